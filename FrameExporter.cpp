@@ -0,0 +1,186 @@
+#include <iostream>
+#include <cstdio>
+#include <cstring>
+#include <cerrno>
+#include <algorithm>
+
+#include <sys/stat.h>
+#ifdef _WIN32
+#include <direct.h>
+#endif
+
+#include <vtkImageData.h>
+#include <vtkPointData.h>
+#include <vtkUnsignedCharArray.h>
+#include <vtkPNGWriter.h>
+
+#include "FrameExporter.h"
+
+/*======================================================================================================================================================
+	FrameExporter::FrameExporter()
+	Fonction : Initialisation (les encodeurs ne sont lancs que par Open)
+======================================================================================================================================================*/
+FrameExporter::FrameExporter()
+{
+	_stop = false;
+	_nb_frames = 0;
+	_nb_waits = 0;
+	_max_frames = 0;
+
+	_windowToImage = vtkSmartPointer<vtkWindowToImageFilter>::New();
+	_windowToImage->SetInputBufferTypeToRGB();
+	_windowToImage->ReadFrontBufferOff(); // En hors cran l'image est dans le back buffer
+}
+
+FrameExporter::~FrameExporter()
+{
+	Finish();
+	for (size_t i = 0; i < _all_frames.size(); i++) delete _all_frames[i];
+}
+
+/*=====================================================================================================================================================
+	bool FrameExporter::Open(const std::string& dossier, int nb_encoders)
+	Fonction : Prpare le dossier de sortie et lance les threads d'encodage.
+	Le dossier est cr s'il n'existe pas (un seul niveau) ; un fichier de test vrifie qu'on peut y crire
+=====================================================================================================================================================*/
+bool FrameExporter::Open(const std::string& dossier, int nb_encoders)
+{
+	_dossier = dossier;
+
+#ifdef _WIN32
+	int resultat = _mkdir(dossier.c_str());
+#else
+	int resultat = mkdir(dossier.c_str(), 0755);
+#endif
+	if (resultat != 0 && errno != EEXIST) {
+		std::cout << "Export : impossible de crer " << dossier << " : " << strerror(errno) << std::endl;
+		return false;
+	}
+
+	std::string test = dossier + "/.frame_export_test";
+	FILE* fichier = fopen(test.c_str(), "wb");
+	if (fichier == NULL) {
+		std::cout << "Export : impossible d'crire dans " << dossier << " : " << strerror(errno) << std::endl;
+		return false;
+	}
+	fclose(fichier);
+	remove(test.c_str());
+
+	if (nb_encoders <= 0) nb_encoders = std::max(1, static_cast<int>(std::thread::hardware_concurrency()) - 1);
+	_max_frames = static_cast<size_t>(NB_Buffer_Export) * nb_encoders;
+
+	_stop = false;
+	for (int i = 0; i < nb_encoders; i++) {
+		_encoders.push_back(std::thread(&FrameExporter::Encode, this));
+	}
+	return true;
+}
+
+/*=====================================================================================================================================================
+	void FrameExporter::Capture(vtkRenderWindow* renderWindow)
+	Fonction : Lit les pixels de la fentre et les copie dans un tampon libre qui part dans la file d'encodage.
+	Les tampons sont allous  la demande jusqu' _max_frames ; au-del on attend qu'un encodeur en rende un.
+	Le verrou n'est jamais tenu pendant la copie ni pendant l'criture du PNG
+=====================================================================================================================================================*/
+void FrameExporter::Capture(vtkRenderWindow* renderWindow)
+{
+	if (_encoders.empty()) return;
+
+	_windowToImage->SetInput(renderWindow);
+	_windowToImage->Modified(); // Force la relecture de la fentre  chaque image
+	_windowToImage->Update();
+
+	vtkImageData* image = _windowToImage->GetOutput();
+	int dims[3];
+	image->GetDimensions(dims);
+	unsigned char* source = static_cast<unsigned char*>(image->GetScalarPointer());
+	size_t taille = static_cast<size_t>(dims[0]) * dims[1] * 3;
+
+	Frame* frame = NULL;
+	{
+		std::unique_lock<std::mutex> lock(_mutex);
+		if (_free_frames.empty() && _all_frames.size() < _max_frames) {
+			frame = new Frame;
+			_all_frames.push_back(frame);
+		}
+		else {
+			if (_free_frames.empty()) ++_nb_waits; // Tous les tampons sont occups : les encodeurs sont le facteur limitant
+			_free_cond.wait(lock, [this] { return !_free_frames.empty(); });
+			frame = _free_frames.back();
+			_free_frames.pop_back();
+		}
+	}
+
+	frame->index = _nb_frames++;
+	frame->width = dims[0];
+	frame->height = dims[1];
+	frame->pixels.resize(taille); // Pas de rallocation si le tampon a dj servi pour la mme taille de fentre
+	memcpy(frame->pixels.data(), source, taille);
+
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_queue.push_back(frame);
+	}
+	_cond.notify_one();
+}
+
+/*=====================================================================================================================================================
+	void FrameExporter::Encode(void)
+	Fonction : Thread d'encodage. Chaque thread a son propre vtkImageData et vtkPNGWriter ;
+	le tampon est envelopp sans copie dans le vtkImageData
+=====================================================================================================================================================*/
+void FrameExporter::Encode(void)
+{
+	vtkSmartPointer<vtkUnsignedCharArray> scalars = vtkSmartPointer<vtkUnsignedCharArray>::New();
+	scalars->SetNumberOfComponents(3);
+	vtkSmartPointer<vtkImageData> image = vtkSmartPointer<vtkImageData>::New();
+	vtkSmartPointer<vtkPNGWriter> writer = vtkSmartPointer<vtkPNGWriter>::New();
+	char nom[32];
+
+	while (true) {
+		Frame* frame = NULL;
+		{
+			std::unique_lock<std::mutex> lock(_mutex);
+			_cond.wait(lock, [this] { return _stop || !_queue.empty(); });
+			if (_queue.empty()) break; // _stop et plus rien  crire
+			frame = _queue.front();
+			_queue.pop_front();
+		}
+
+		//Le dernier argument (save = 1) indique  VTK de ne pas librer la mmoire du tampon
+		scalars->SetArray(frame->pixels.data(), frame->pixels.size(), 1);
+		image->SetDimensions(frame->width, frame->height, 1);
+		image->GetPointData()->SetScalars(scalars);
+
+		snprintf(nom, sizeof(nom), "/frame_%06d.png", frame->index);
+		writer->SetFileName((_dossier + nom).c_str());
+		writer->SetInputData(image);
+		writer->Write();
+
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+			_free_frames.push_back(frame);
+		}
+		_free_cond.notify_one();
+	}
+}
+
+/*=====================================================================================================================================================
+	void FrameExporter::Finish(void)
+	Fonction : Vide la file d'encodage puis arrte les threads
+=====================================================================================================================================================*/
+void FrameExporter::Finish(void)
+{
+	if (_encoders.empty()) return;
+
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_stop = true;
+	}
+	_cond.notify_all();
+	for (size_t i = 0; i < _encoders.size(); i++) _encoders[i].join();
+
+	std::cout << "Export : " << _nb_frames << " images crites dans " << _dossier << " (" << _encoders.size() << " encodeurs, "
+		<< _all_frames.size() << " tampons, " << _nb_waits << " attentes du rendu)" << std::endl;
+	_encoders.clear();
+}
@@ -0,0 +1,78 @@
+#ifndef _FrameExporter_H_
+#define _FrameExporter_H_
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+#include <vtkSmartPointer.h>
+#include <vtkRenderWindow.h>
+#include <vtkWindowToImageFilter.h>
+
+#define NB_Buffer_Export 4	//	Nombre de tampons d'image par thread d'encodage (taille maximale de la rserve = NB_Buffer_Export x encodeurs)
+
+/*=========================================================================================================================
+	class FrameExporter
+	Fonction :
+		++ Capture chaque image du vtkRenderWindow (hors cran) avec un vtkWindowToImageFilter
+		++ Copie les pixels dans une rserve de tampons rutilisables, de taille borne
+		++ Confie les tampons  plusieurs threads d'encodage qui crivent une squence PNG (frame_000000.png, frame_000001.png...)
+	Les images peuvent tre termines dans le dsordre, le nom du fichier porte leur numro.
+	Quand tous les tampons sont en cours d'encodage, Capture attend qu'un tampon se libre : le rendu est alors limit par la
+	vitesse d'encodage (aucune image n'est perdue et la mmoire reste borne). Le nombre d'attentes est affich par Finish.
+==========================================================================================================================*/
+
+class FrameExporter {
+public:
+	FrameExporter();
+	~FrameExporter();
+
+	//\\//\\Cre le dossier si besoin, vrifie qu'il est accessible en criture et lance les encodeurs \\//\\//
+	//\\//\\nb_encoders = 0 -> nombre de coeurs - 1 (au moins 1). Retourne false en cas d'chec \\//\\//
+	bool Open(const std::string& dossier, int nb_encoders = 0);
+
+	//\\//\\Capture l'image courante de la fentre et la place dans la file d'encodage \\//\\//
+	void Capture(vtkRenderWindow* renderWindow);
+
+	//\\//\\Attend que toutes les images soient crites puis arrte les threads d'encodage \\//\\//
+	void Finish(void);
+
+	//\\//\\Retourne le nombre d'images captures \\//\\//
+	int get_nb_frames() {
+		return _nb_frames;
+	}
+
+private:
+	//Tampon d'image : pixels RGB bruts et dimensions
+	struct Frame {
+		int index;
+		int width;
+		int height;
+		std::vector<unsigned char> pixels;
+	};
+
+	//\\//\\Boucle d'un thread d'encodage : crit les images en PNG et rend les tampons  la rserve \\//\\//
+	void Encode(void);
+
+	std::string _dossier;
+	vtkSmartPointer<vtkWindowToImageFilter> _windowToImage;
+
+	//Rserve de tampons libres et file des tampons  encoder (protges par _mutex)
+	std::vector<Frame*> _all_frames;
+	std::vector<Frame*> _free_frames;
+	std::deque<Frame*> _queue;
+	size_t _max_frames;
+	std::mutex _mutex;
+	std::condition_variable _cond;		//une image attend d'tre encode
+	std::condition_variable _free_cond;	//un tampon est revenu dans la rserve
+	bool _stop;
+
+	std::vector<std::thread> _encoders;
+	int _nb_frames;
+	int _nb_waits;
+};
+
+#endif
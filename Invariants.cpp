@@ -0,0 +1,128 @@
+#include <iostream>
+
+#include "Invariants.h"
+
+/*======================================================================================================================================================
+	InvariantMonitor::InvariantMonitor(int cadence, double budget, const char* fichier, bool auto_pas)
+	Fonction : Initialisation et criture de l'en-tte du fichier CSV
+		cadence : nombre de pas entre deux chantillons
+		budget : drive relative tolre (nergie ou moment cintique) entre deux chantillons avant alerte
+		fichier : fichier CSV de sortie
+		auto_pas : divise le pas par 2 quand le budget est dpass et le double  nouveau quand la drive redevient faible
+======================================================================================================================================================*/
+InvariantMonitor::InvariantMonitor(int cadence, double budget, const char* fichier, bool auto_pas)
+{
+	_cadence = (cadence > 0) ? cadence : 1;
+	_budget = budget;
+	_auto_pas = auto_pas;
+	_step = 0;
+	_nb_samples = 0;
+	_nb_calmes = 0;
+
+	_csv.open(fichier);
+	if (!_csv) std::cout << "Invariants : impossible d'ouvrir " << fichier << std::endl;
+	_csv << "temps,pas,energie,moment_cinetique,derive_energie,derive_moment,centre_masse_x,centre_masse_y,derive_centre_masse" << std::endl;
+	_csv.precision(12);
+}
+
+/*=====================================================================================================================================================
+	bool InvariantMonitor::Begin_sample(double temps)
+	Fonction : Compte les pas et remet les cumuls  zro quand le pas courant est chantillonn
+=====================================================================================================================================================*/
+bool InvariantMonitor::Begin_sample(double temps)
+{
+	if (_step++ % _cadence != 0) return false;
+
+	_temps = temps;
+	_energie = 0;
+	_moment = 0;
+	_masse = MASSEsoleil; // soleil fixe  l'origine : ne contribue qu' la masse du barycentre
+	_moment_masse[0] = 0;
+	_moment_masse[1] = 0;
+	return true;
+}
+
+void InvariantMonitor::Accumulate(Planet& planet)
+{
+	double masse = planet.get_weight();
+	_energie += planet.get_energy();
+	_moment += planet.get_angular_momentum();
+	_masse += masse;
+	_moment_masse[0] += masse * planet.get_position_x();
+	_moment_masse[1] += masse * planet.get_position_y();
+}
+
+/*=====================================================================================================================================================
+	double InvariantMonitor::End_sample(double pas)
+	Fonction : Calcule les drives, crit la ligne CSV et vrifie le budget.
+	Le budget porte sur la drive depuis l'chantillon prcdent (vitesse de drive) et non sur la drive cumule :
+	la drive dj accumule ne se corrige pas en rduisant le pas, elle ne doit pas empcher le pas de remonter.
+	Le pas retourn n'est utilis qu' l'appel suivant du timer : d'ici l les chantillons voient encore l'ancien pas
+=====================================================================================================================================================*/
+double InvariantMonitor::End_sample(double pas)
+{
+	double centre_masse[2] = { _moment_masse[0] / _masse, _moment_masse[1] / _masse };
+
+	if (_nb_samples == 0) {
+		_energie0 = _energie_prec = _energie;
+		_moment0 = _moment_prec = _moment;
+		_centre_masse0[0] = centre_masse[0];
+		_centre_masse0[1] = centre_masse[1];
+		_pas_demande = _pas_prec = pas;
+	}
+	++_nb_samples;
+
+	_last.temps = _temps;
+	_last.pas = pas;
+	_last.energie = _energie;
+	_last.moment_cinetique = _moment;
+	_last.derive_energie = fabs(_energie - _energie0) / fabs(_energie0);
+	_last.derive_moment = fabs(_moment - _moment0) / fabs(_moment0);
+	_last.centre_masse[0] = centre_masse[0];
+	_last.centre_masse[1] = centre_masse[1];
+	_last.derive_centre_masse = sqrt(pow(centre_masse[0] - _centre_masse0[0], 2) + pow(centre_masse[1] - _centre_masse0[1], 2));
+
+	_csv << _last.temps << "," << _last.pas << "," << _last.energie << "," << _last.moment_cinetique << ","
+		<< _last.derive_energie << "," << _last.derive_moment << ","
+		<< _last.centre_masse[0] << "," << _last.centre_masse[1] << "," << _last.derive_centre_masse << "\n";
+
+	double derive_energie = fabs(_energie - _energie_prec) / fabs(_energie0);
+	double derive_moment = fabs(_moment - _moment_prec) / fabs(_moment0);
+	_energie_prec = _energie;
+	_moment_prec = _moment;
+
+	//Un changement de pas est dj demand : il ne s'applique qu'au prochain appel du timer, inutile de le redemander
+	if (pas != _pas_demande) return _pas_demande;
+
+	//Premier chantillon au nouveau pas : son intervalle mlange l'ancien et le nouveau pas, il n'est pas jug
+	bool melange = (pas != _pas_prec);
+	_pas_prec = pas;
+	if (melange) {
+		_nb_calmes = 0;
+		return pas;
+	}
+
+	if (derive_energie > _budget || derive_moment > _budget) {
+		std::cout << "ALERTE invariants : t = " << _temps << " s, derive energie " << derive_energie
+			<< ", derive moment cinetique " << derive_moment << " par echantillon (budget " << _budget << ")" << std::endl;
+		_nb_calmes = 0;
+		if (!_auto_pas || pas / 2 < PAS_min) return pas;
+
+		std::cout << "Pas reduit : " << pas << " s -> " << pas / 2 << " s" << std::endl;
+		_pas_demande = pas / 2;
+		return _pas_demande;
+	}
+
+	//\\//\\Hystrsis : le pas ne remonte que si la drive reste nettement sous le budget \\//\\//
+	if (!_auto_pas || pas * 2 > h) return pas;
+	if (derive_energie * PAS_marge > _budget || derive_moment * PAS_marge > _budget) {
+		_nb_calmes = 0;
+		return pas;
+	}
+	if (++_nb_calmes < PAS_calme) return pas;
+
+	_nb_calmes = 0;
+	std::cout << "Pas augmente : " << pas << " s -> " << pas * 2 << " s" << std::endl;
+	_pas_demande = pas * 2;
+	return _pas_demande;
+}
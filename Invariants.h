@@ -0,0 +1,88 @@
+#ifndef _Invariants_H_
+#define _Invariants_H_
+
+#include <fstream>
+
+#include "Planet.h"
+
+#define PAS_min (h / 64.)	//	Plus petit pas accept par la rduction automatique
+#define PAS_marge 8.		//	Le pas double quand la drive par chantillon reste sous budget / PAS_marge (hystrsis)
+#define PAS_calme 4			//	... pendant PAS_calme chantillons conscutifs
+
+/*=========================================================================================================================
+	struct Invariant_Sample
+	Fonction : Valeurs des invariants pour un chantillon (systme plantes + soleil fixe  l'origine)
+==========================================================================================================================*/
+
+struct Invariant_Sample {
+	double temps;				//temps simul (s)
+	double pas;					//pas utilis (s)
+	double energie;				//nergie totale (J)
+	double moment_cinetique;	//moment cintique total suivant z (kg.m/s)
+	double derive_energie;		//|E - E0| / |E0| depuis le dpart
+	double derive_moment;		//|L - L0| / |L0| depuis le dpart
+	double centre_masse[2];		//barycentre du systme (m)
+	double derive_centre_masse;	//dplacement du barycentre depuis le dpart (m)
+};
+
+/*=========================================================================================================================
+	class InvariantMonitor
+	Fonction :
+		++ Cumule l'nergie, le moment cintique et le barycentre plante par plante pendant le calcul des positions
+		   (les valeurs viennent de la distance dj calcule par Planet::distance, pas de second parcours)
+		++ Echantillonne tous les cadence pas et crit une ligne CSV
+		++ Signale une alerte quand la drive d'nergie ou de moment cintique entre deux chantillons dpasse le budget
+		++ Peut adapter le pas : division par 2  chaque alerte (jusqu' PAS_min), multiplication par 2 (jusqu' h) quand la drive
+		   par chantillon reste sous budget / PAS_marge pendant PAS_calme chantillons. Le schma tant d'ordre 1, doubler le pas
+		   multiplie environ par 4 la drive par chantillon : la marge vite d'osciller entre deux pas
+	Le soleil est fixe dans ce modle : le barycentre n'est pas conserv, sa drive est donne  titre indicatif et ne dclenche pas d'alerte
+==========================================================================================================================*/
+
+class InvariantMonitor {
+public:
+	InvariantMonitor(int cadence, double budget, const char* fichier, bool auto_pas);
+
+	//\\//\\Dbut d'un pas de calcul. Retourne true si ce pas est chantillonn \\//\\//
+	bool Begin_sample(double temps);
+
+	//\\//\\Ajoute la contribution d'une plante ( appeler juste aprs planet.distance()) \\//\\//
+	void Accumulate(Planet& planet);
+
+	//\\//\\Termine l'chantillon, crit la ligne CSV et retourne le pas  utiliser pour la suite ( appliquer au prochain appel du timer) \\//\\//
+	double End_sample(double pas);
+
+	//\\//\\Retourne le dernier chantillon (NULL si aucun) \\//\\//
+	const Invariant_Sample* get_last() {
+		return (_nb_samples > 0) ? &_last : NULL;
+	}
+
+private:
+	int _cadence;
+	double _budget;
+	bool _auto_pas;
+	std::ofstream _csv;
+
+	long _step;
+	long _nb_samples;
+	int _nb_calmes;				//chantillons conscutifs sous budget / PAS_marge
+	double _pas_prec;			//pas de l'chantillon prcdent
+	double _pas_demande;		//dernier pas retourn par End_sample
+
+	//Cumuls de l'chantillon en cours
+	double _temps;
+	double _energie;
+	double _moment;
+	double _masse;
+	double _moment_masse[2];
+
+	//Rfrences : au dpart, et  l'chantillon prcdent pour le budget
+	double _energie0;
+	double _moment0;
+	double _centre_masse0[2];
+	double _energie_prec;
+	double _moment_prec;
+
+	Invariant_Sample _last;
+};
+
+#endif
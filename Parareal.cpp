@@ -0,0 +1,263 @@
+#include <iostream>
+#include <chrono>
+#include <algorithm>
+
+#include "Parareal.h"
+
+/*======================================================================================================================================================
+	Parareal::Parareal(double duree, int nb_tranches, double pas_grossier, int iter_max, double tolerance, int nb_threads)
+	Fonction : Initialisation. La dcoupe en fentres et en tranches dpend de la priode de la plante et n'est faite que par Run.
+	iter_max = 0 -> nb_tranches (Parareal converge au plus tard en nb_tranches itrations par fentre)
+	tolerance est une fraction de l'erreur du propagateur fin (voir Parareal.h)
+	duree > 0, nb_tranches > 0 et pas_grossier > h sont  vrifier par l'appelant (voir Run_Parareal)
+======================================================================================================================================================*/
+Parareal::Parareal(double duree, int nb_tranches, double pas_grossier, int iter_max, double tolerance, int nb_threads)
+{
+	_duree = duree;
+	_nb_tranches = std::max(1, nb_tranches);
+	_iter_max = (iter_max > 0) ? std::min(iter_max, _nb_tranches) : _nb_tranches;
+	_tolerance = tolerance;
+	_nb_threads = (nb_threads > 0) ? nb_threads : std::max(1u, std::thread::hardware_concurrency());
+	_pas_grossier_demande = pas_grossier;
+	_seuil = 0;
+	_nb_fenetres = 1;
+	_nb_pas_fin = 1;
+	_nb_pas_grossier = 1;
+	_pas_grossier = h;
+
+	_U.resize(4 * (_nb_tranches + 1));
+	_fine.resize(4 * _nb_tranches);
+	_coarse.resize(4 * _nb_tranches);
+	_temps_tranche.resize(_nb_tranches);
+
+	_planet = NULL;
+	_generation = 0;
+	_actifs = 0;
+	_stop = false;
+	_next = 0;
+}
+
+Parareal::~Parareal()
+{
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_stop = true;
+	}
+	_cond.notify_all();
+	for (size_t t = 0; t < _workers.size(); t++) _workers[t].join();
+}
+
+/*=====================================================================================================================================================
+	void Parareal::Propagate(Planet& planet, double state[4], double pas, long nb_pas)
+	Fonction : Mme enchanement que le programme d'interruption (distance, position puis vitesse) avec le pas demand
+=====================================================================================================================================================*/
+void Parareal::Propagate(Planet& planet, double state[4], double pas, long nb_pas)
+{
+	planet.set_state(state[0], state[1], state[2], state[3]);
+	for (long i = 0; i < nb_pas; i++) {
+		planet.distance();
+		planet.Update_position_Runge_Kutta(2, pas);
+		planet.Update_position_Runge_Kutta(1, pas);
+	}
+	state[0] = planet.get_position_x();
+	state[1] = planet.get_position_y();
+	state[2] = planet.get_velocity_x();
+	state[3] = planet.get_velocity_y();
+}
+
+/*=====================================================================================================================================================
+	double Parareal::Fine_parallel(const Planet& planet, int first)
+	Fonction : Distribue une itration aux threads de propagation fine (lancs au premier appel) et attend qu'ils aient fini.
+	Chaque thread prend la prochaine tranche libre et la propage au pas fin  partir de _U[n].
+	Les tranches avant first ont dj converg et ne sont pas recalcules.
+	Retourne la somme des temps de calcul des tranches (temps qu'aurait pris ce travail en srie)
+=====================================================================================================================================================*/
+double Parareal::Fine_parallel(const Planet& planet, int first)
+{
+	if (_workers.empty()) {
+		int nb_threads = std::min(_nb_threads, _nb_tranches);
+		for (int t = 0; t < nb_threads; t++) _workers.push_back(std::thread(&Parareal::Worker, this));
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_planet = &planet;
+		_next = first;
+		_actifs = static_cast<int>(_workers.size());
+		++_generation;
+	}
+	_cond.notify_all();
+	{
+		std::unique_lock<std::mutex> lock(_mutex);
+		_done_cond.wait(lock, [this] { return _actifs == 0; });
+	}
+
+	double total = 0;
+	for (int n = first; n < _nb_tranches; n++) total += _temps_tranche[n];
+	return total;
+}
+
+/*=====================================================================================================================================================
+	void Parareal::Worker(void)
+	Fonction : Thread de propagation fine. Une itration n'est distribue que quand tous les threads ont fini la prcdente :
+	chaque thread voit donc chaque itration exactement une fois
+=====================================================================================================================================================*/
+void Parareal::Worker(void)
+{
+	long generation = 0;
+	while (true) {
+		const Planet* planet = NULL;
+		{
+			std::unique_lock<std::mutex> lock(_mutex);
+			_cond.wait(lock, [this, generation] { return _stop || _generation != generation; });
+			if (_stop) return;
+			generation = _generation;
+			planet = _planet;
+		}
+
+		Planet local = *planet;
+		int n;
+		while ((n = _next++) < _nb_tranches) {
+			std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+			double state[4] = { _U[4 * n], _U[4 * n + 1], _U[4 * n + 2], _U[4 * n + 3] };
+			Propagate(local, state, h, _nb_pas_fin);
+			for (int j = 0; j < 4; j++) _fine[4 * n + j] = state[j];
+			_temps_tranche[n] = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		}
+
+		bool dernier;
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+			dernier = (--_actifs == 0);
+		}
+		if (dernier) _done_cond.notify_one();
+	}
+}
+
+/*=====================================================================================================================================================
+	Parareal_Result Parareal::Run(const Planet& planet, bool reference)
+	Fonction :
+		1 -> Dcoupe : tranches d'au plus priode / PARAREAL_tranches_orbite, regroupes en fentres de nb_tranches tranches.
+		     La dure est arrondie  un nombre entier de pas h par tranche pour que les deux propagateurs couvrent exactement le mme intervalle
+		2 -> (option) Intgration fine en srie, rfrence pour le speedup et l'erreur
+		3 -> Parareal sur chaque fentre, l'tat final d'une fentre est l'tat de dpart de la suivante
+=====================================================================================================================================================*/
+Parareal_Result Parareal::Run(const Planet& planet, bool reference)
+{
+	Parareal_Result result;
+	Planet local = planet;
+	double depart[4] = { local.get_position_x(), local.get_position_y(), local.get_velocity_x(), local.get_velocity_y() };
+
+	//\\//\\Dcoupe en fentres et en tranches \\//\\//
+	double tranche_max = std::min(_duree / _nb_tranches, local.get_periode() / PARAREAL_tranches_orbite);
+	_nb_fenetres = std::max(1, static_cast<int>(ceil(_duree / (_nb_tranches * tranche_max) - 1E-9)));
+	_nb_pas_fin = std::max(1L, static_cast<long>(_duree / (h * _nb_tranches * _nb_fenetres) + 0.5));
+	double tranche = _nb_pas_fin * h;
+	_nb_pas_grossier = std::max(1L, static_cast<long>(tranche / _pas_grossier_demande + 0.5));
+	_pas_grossier = tranche / _nb_pas_grossier;
+
+	//\\//\\Rfrence : intgration fine en srie sur toute la dure \\//\\//
+	double serie[4] = { depart[0], depart[1], depart[2], depart[3] };
+	result.reference = reference;
+	result.temps_serie = 0;
+	if (reference) {
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		Propagate(local, serie, h, _nb_pas_fin * _nb_tranches * _nb_fenetres);
+		result.temps_serie = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	}
+
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+	//\\//\\Fentres successives \\//\\//
+	//Cot en pas (fin = 1, grossier = 1) pour le speedup idal : srie = N x nf par fentre
+	double cout_serie = static_cast<double>(_nb_fenetres) * _nb_tranches * _nb_pas_fin;
+	double cout_parareal = 0;
+	result.iterations = 0;
+	result.fenetres = _nb_fenetres;
+	result.statut = PARAREAL_CONVERGE;
+	result.erreur_fine = 0;
+	for (int j = 0; j < 4; j++) _U[j] = depart[j];
+	for (int f = 0; f < _nb_fenetres; f++) {
+		Parareal_Status statut = Window(planet, result, cout_parareal, f == 0);
+		if (statut > result.statut) result.statut = statut;
+		for (int j = 0; j < 4; j++) _U[j] = _U[4 * _nb_tranches + j];
+	}
+
+	result.temps_parareal = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	result.speedup = (result.temps_parareal > 0) ? result.temps_serie / result.temps_parareal : 0;
+	result.speedup_ideal = cout_serie / cout_parareal;
+
+	result.erreur = -1;
+	if (reference) {
+		result.erreur = sqrt(pow(_U[0] - serie[0], 2) + pow(_U[1] - serie[1], 2)) / sqrt(pow(serie[0], 2) + pow(serie[1], 2));
+	}
+
+	return result;
+}
+
+/*=====================================================================================================================================================
+	Parareal_Status Parareal::Window(const Planet& planet, Parareal_Result& result, double& cout_parareal, bool premiere)
+	Fonction :
+		1 -> Balayage grossier de toutes les tranches : U[n+1] = G(U[n])
+		2 -> Itrations : F(U[n]) en parallle puis correction en srie U[n+1] = G(U[n]) + F(U[n]) - G_prcdent(U[n])
+		3 -> Arrt quand la plus grande correction relative de position passe sous tolerance x erreur du propagateur fin
+	cout_parareal cumule les pas calculs, un coeur par tranche : balayage N x ng puis, par itration k, nf + (N - k) x ng
+=====================================================================================================================================================*/
+Parareal_Status Parareal::Window(const Planet& planet, Parareal_Result& result, double& cout_parareal, bool premiere)
+{
+	Planet local = planet;
+
+	//\\//\\Balayage grossier initial \\//\\//
+	for (int n = 0; n < _nb_tranches; n++) {
+		double state[4] = { _U[4 * n], _U[4 * n + 1], _U[4 * n + 2], _U[4 * n + 3] };
+		Propagate(local, state, _pas_grossier, _nb_pas_grossier);
+		for (int j = 0; j < 4; j++) {
+			_coarse[4 * n + j] = state[j];
+			_U[4 * (n + 1) + j] = state[j];
+		}
+	}
+	cout_parareal += static_cast<double>(_nb_tranches) * _nb_pas_grossier;
+
+	//\\//\\Itrations de correction \\//\\//
+	for (int k = 0; k < _iter_max; k++) {
+		double temps_fin = Fine_parallel(planet, k);
+		result.iterations = std::max(result.iterations, k + 1);
+		cout_parareal += _nb_pas_fin + static_cast<double>(_nb_tranches - k) * _nb_pas_grossier;
+
+		if (k == 0) {
+			//Premire itration : toutes les tranches fines sont calcules, leur somme estime le temps srie
+			if (!result.reference) result.temps_serie += temps_fin;
+
+			//Erreur propre du propagateur fin, estime sur la premire tranche (schma d'ordre 1)
+			if (premiere && _pas_grossier > h) {
+				double rayon = sqrt(pow(_fine[0], 2) + pow(_fine[1], 2));
+				double ecart = sqrt(pow(_fine[0] - _coarse[0], 2) + pow(_fine[1] - _coarse[1], 2)) / rayon;
+				result.erreur_fine = ecart * h / (_pas_grossier - h);
+				_seuil = _tolerance * result.erreur_fine;
+			}
+		}
+
+		//La tranche k part d'un tat exact : U[k+1] = F(U[k]) est exact lui aussi
+		double correction = 0;
+		for (int n = k; n < _nb_tranches; n++) {
+			double state[4] = { _U[4 * n], _U[4 * n + 1], _U[4 * n + 2], _U[4 * n + 3] };
+			Propagate(local, state, _pas_grossier, _nb_pas_grossier);
+
+			double* U_next = &_U[4 * (n + 1)];
+			double ancien_x = U_next[0];
+			double ancien_y = U_next[1];
+			for (int j = 0; j < 4; j++) {
+				U_next[j] = state[j] + _fine[4 * n + j] - _coarse[4 * n + j];
+				_coarse[4 * n + j] = state[j];
+			}
+			double rayon = sqrt(pow(U_next[0], 2) + pow(U_next[1], 2));
+			double ecart = sqrt(pow(U_next[0] - ancien_x, 2) + pow(U_next[1] - ancien_y, 2)) / rayon;
+			correction = std::max(correction, ecart);
+		}
+
+		if (correction < _seuil) return PARAREAL_CONVERGE;
+		//Aprs k+1 itrations les k+1 premires tranches sont exactes : au plus nb_tranches itrations
+		if (k + 1 == _nb_tranches) return PARAREAL_PLAFOND;
+	}
+	return PARAREAL_NON_CONVERGE;
+}
@@ -0,0 +1,117 @@
+#ifndef _Parareal_H_
+#define _Parareal_H_
+
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+
+#include "Planet.h"
+
+#define PAS_grossier 3600.	//	Pas par dfaut du propagateur grossier (1 heure au lieu de h)
+#define PARAREAL_tolerance 0.1	//	Fraction de l'erreur propre du propagateur fin : on arrte quand la correction devient plus petite que tolerance x erreur fine
+#define PARAREAL_tranches_orbite 32	//	Nombre minimal de tranches par priode de rvolution
+
+/*=========================================================================================================================
+	enum Parareal_Status
+	Fonction : Raison de l'arrt des itrations
+		++ PARAREAL_CONVERGE : la correction est passe sous la tolrance
+		++ PARAREAL_PLAFOND : arrt parce que le nombre d'itrations a atteint le nombre de tranches ; le rsultat est exact
+		   mais Parareal a fait nb_tranches fois le travail fin de l'intgration en srie (aucun gain)
+		++ PARAREAL_NON_CONVERGE : iter_max atteint avant la tolrance
+==========================================================================================================================*/
+
+enum Parareal_Status {
+	PARAREAL_CONVERGE,
+	PARAREAL_PLAFOND,
+	PARAREAL_NON_CONVERGE
+};
+
+/*=========================================================================================================================
+	struct Parareal_Result
+	Fonction : Bilan d'une intgration Parareal compare  l'intgration fine en srie
+==========================================================================================================================*/
+
+struct Parareal_Result {
+	int iterations;			//nombre d'itrations Parareal de la fentre la plus lente
+	int fenetres;			//nombre de fentres de nb_tranches tranches traites l'une aprs l'autre
+	Parareal_Status statut;	//raison de l'arrt (la pire des fentres)
+	bool reference;			//vrai si l'intgration fine en srie a rellement t faite
+	double temps_serie;		//temps de calcul (s) de l'intgration fine en srie, mesur ou estim (somme des tranches fines de la 1re itration)
+	double temps_parareal;	//temps de calcul (s) de Parareal
+	double speedup;			//temps_serie / temps_parareal sur cette machine
+	double speedup_ideal;	//speedup attendu avec un coeur par tranche, d'aprs le nombre de pas fins et grossiers calculs
+	double erreur_fine;		//erreur relative estime du propagateur fin sur une tranche
+	double erreur;			//cart relatif de position final avec la solution srie (-1 sans rfrence)
+};
+
+/*=========================================================================================================================
+	class Parareal
+	Fonction :
+		++ Dcoupe la dure de simulation en fentres successives de nb_tranches tranches de temps
+		++ Dans chaque fentre, balaye toutes les tranches avec le propagateur grossier (Runge Kutta  grand pas)
+		++ Affine les tranches en parallle avec le propagateur fin (Runge Kutta au pas h) et corrige jusqu' convergence
+	Une tranche ne doit couvrir qu'une petite fraction d'orbite : sur plusieurs rvolutions, l'erreur de phase des propagateurs
+	fait diverger les corrections (Mercure, Vnus et la Terre sur 100 ans en 64 tranches). La longueur des tranches est donc
+	limite  priode / PARAREAL_tranches_orbite, et la dure est parcourue en autant de fentres que ncessaire.
+	Les threads de propagation fine sont crs au premier Run et rutiliss pour toutes les itrations de toutes les fentres
+	(une tranche fine ne dure que quelques centaines de s : recrer les threads  chaque itration coterait plus que le calcul).
+	Le schma de Runge Kutta de Planet est d'ordre 1 : l'cart entre propagateurs fin et grossier sur la premire tranche donne
+	l'erreur propre du propagateur fin, erreur_fine = |F - G| x h / (pas_grossier - h). Itrer au-del de cette erreur n'apporte rien,
+	la tolrance lui est donc relative.
+==========================================================================================================================*/
+
+class Parareal {
+public:
+	Parareal(double duree, int nb_tranches, double pas_grossier = PAS_grossier, int iter_max = 0, double tolerance = PARAREAL_tolerance, int nb_threads = 0);
+	~Parareal();
+
+	//\\//\\Intgre la plante sur la dure demande (la plante passe n'est pas modifie). La dcoupe dpend de sa priode \\//\\//
+	//\\//\\reference : refait d'abord toute l'intgration fine en srie pour mesurer le speedup et l'erreur (double le temps de calcul) \\//\\//
+	Parareal_Result Run(const Planet& planet, bool reference = false);
+
+private:
+	//\\//\\Avance l'tat (x, y, vx, vy) de nb_pas pas de Runge Kutta \\//\\//
+	static void Propagate(Planet& planet, double state[4], double pas, long nb_pas);
+
+	//\\//\\Itrations Parareal sur une fentre partant de _U[0]. La premire fentre fixe l'erreur du propagateur fin et le seuil \\//\\//
+	Parareal_Status Window(const Planet& planet, Parareal_Result& result, double& cout_parareal, bool premiere);
+
+	//\\//\\Propagation fine de toutes les tranches  partir de first, rparties sur les threads. Retourne la somme des temps par tranche \\//\\//
+	double Fine_parallel(const Planet& planet, int first);
+
+	//\\//\\Boucle d'un thread de propagation fine : attend une nouvelle itration, prend des tranches jusqu' puisement \\//\\//
+	void Worker(void);
+
+	double _duree;
+	int _nb_tranches;
+	int _iter_max;
+	int _nb_threads;
+	double _tolerance;
+	double _pas_grossier_demande;
+	double _seuil;				//tolerance x erreur du propagateur fin
+	int _nb_fenetres;
+	long _nb_pas_fin;			//pas h par tranche
+	long _nb_pas_grossier;		//pas grossiers par tranche
+	double _pas_grossier;		//pas grossier rellement utilis (la tranche en est un multiple exact)
+
+	//tats aux frontires des tranches et rsultats des propagateurs (x, y, vx, vy)
+	std::vector<double> _U;
+	std::vector<double> _fine;
+	std::vector<double> _coarse;
+	std::vector<double> _temps_tranche;
+
+	//Threads de propagation fine et distribution du travail (protgs par _mutex, sauf _next)
+	std::vector<std::thread> _workers;
+	std::mutex _mutex;
+	std::condition_variable _cond;		//une nouvelle itration est disponible
+	std::condition_variable _done_cond;	//tous les threads ont fini l'itration
+	const Planet* _planet;
+	long _generation;					//numro de l'itration distribue
+	int _actifs;						//threads qui n'ont pas encore fini l'itration
+	bool _stop;
+	std::atomic<int> _next;				//prochaine tranche libre
+};
+
+#endif
@@ -64,6 +64,15 @@ void Planet::Update_position_Euler(int cases)
 	Fonction : Calcul les nouveaux coordonnes des plantes. Les dtails pour obtenir les formes ci-desssous sont dans le fichier Readme
 =====================================================================================================================================================*/
 void Planet::Update_position_Runge_Kutta(int cases)
+{
+	Update_position_Runge_Kutta(cases, h);
+}
+
+/*=====================================================================================================================================================
+	void Planet::Update_position_Runge_Kutta(int cases, double pas)
+	Fonction : Mme schma de Runge Kutta avec un pas de temps pass en paramtre au lieu de la constante h
+=====================================================================================================================================================*/
+void Planet::Update_position_Runge_Kutta(int cases, double pas)
 {
 	/********************************************************************************************************************/
 	/*Calcul de la position de la plante basse sur l'algorithme de Runge Kutta pour le calcul diffrentiel voir notes*/
@@ -71,13 +80,13 @@ void Planet::Update_position_Runge_Kutta(int cases)
 	switch (cases) {
 	case 1:
 		//std::cout << "velocity_x : " << _velocity_xt <<"	velocity_y : "<< _velocity_yt<<"	velocity_x0 : "<<_velocity_x0 << "	velocity_y0 : " << _velocity_y0 << std::endl;
-		_velocity_xt = _velocity_xt * (1 - (h * h * _r_weight * GRAVI / (2 * pow(_distance, 3)))) - h * _r_weight * GRAVI * _positionX / pow(_distance, 3);//renvoie la vitesse Vx
-		_velocity_yt = _velocity_yt * (1 - (h * h * _r_weight * GRAVI / (2 * pow(_distance, 3)))) - h * _r_weight * GRAVI * _positionY / pow(_distance, 3);//renvoie la vitesse Vy			
+		_velocity_xt = _velocity_xt * (1 - (pas * pas * _r_weight * GRAVI / (2 * pow(_distance, 3)))) - pas * _r_weight * GRAVI * _positionX / pow(_distance, 3);//renvoie la vitesse Vx
+		_velocity_yt = _velocity_yt * (1 - (pas * pas * _r_weight * GRAVI / (2 * pow(_distance, 3)))) - pas * _r_weight * GRAVI * _positionY / pow(_distance, 3);//renvoie la vitesse Vy			
 		break;
 	case 2:
 		//std::cout << "position_x : " << _positionX << "	position_y : " << _positionY << "	position_x0 : " << _position_x0 << "	position_y0 : " << _position_y0 << std::endl;
-		_positionX = _positionX * (1 - (h * h * _r_weight * GRAVI / (2 * pow(_distance, 3)))) + h * _velocity_xt;//renvoie la position X
-		_positionY = _positionY * (1 - (h * h * _r_weight * GRAVI / (2 * pow(_distance, 3)))) + h * _velocity_yt;//renvoie la position Y
+		_positionX = _positionX * (1 - (pas * pas * _r_weight * GRAVI / (2 * pow(_distance, 3)))) + pas * _velocity_xt;//renvoie la position X
+		_positionY = _positionY * (1 - (pas * pas * _r_weight * GRAVI / (2 * pow(_distance, 3)))) + pas * _velocity_yt;//renvoie la position Y
 		break;
 	}
 }
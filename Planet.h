@@ -60,6 +60,9 @@ public:
 	//\\//\\Calul des nouveaux coordonnes (positions en x, y et vitesse en x, y) de chaque plante en utilisant la mthode de Runge Kutta \\//\\//
 	void Update_position_Runge_Kutta(int cases);
 
+	//\\//\\Mme calcul avec un pas choisi (utilis par le propagateur grossier de Parareal) \\//\\//
+	void Update_position_Runge_Kutta(int cases, double pas);
+
 	//\\//\\Calcule la distance entre la nouvelle position de la plante et le soleil  \\//\\//
 	void distance(void);
 
@@ -73,6 +76,44 @@ public:
 		return _positionY;
 	}
 
+	//\\//\\Retourne la vitesse en x de la plante \\//\\//
+	double get_velocity_x() {
+		return _velocity_xt;
+	}
+
+	//\\//\\Retourne la vitesse en y de la plante \\//\\//
+	double get_velocity_y() {
+		return _velocity_yt;
+	}
+
+	//\\//\\Retourne la masse de la plante \\//\\//
+	double get_weight() {
+		return _p_weight;
+	}
+
+	//\\//\\Retourne la priode de rvolution de la plante \\//\\//
+	double get_periode() {
+		return _p_periode;
+	}
+
+	//\\//\\Retourne l'nergie (cintique + potentielle) de la plante. Utilise la distance calcule par distance() \\//\\//
+	double get_energy() {
+		return 0.5 * _p_weight * (_velocity_xt * _velocity_xt + _velocity_yt * _velocity_yt) - GRAVI * _r_weight * _p_weight / _distance;
+	}
+
+	//\\//\\Retourne le moment cintique de la plante suivant z \\//\\//
+	double get_angular_momentum() {
+		return _p_weight * (_positionX * _velocity_yt - _positionY * _velocity_xt);
+	}
+
+	//\\//\\Remplace la position et la vitesse courantes (tat de dpart d'une tranche de temps) \\//\\//
+	void set_state(double position_x, double position_y, double velocity_x, double velocity_y) {
+		_positionX = position_x;
+		_positionY = position_y;
+		_velocity_xt = velocity_x;
+		_velocity_yt = velocity_y;
+	}
+
 private:
 	//constantes des plantes lors de l'initialisation
 	double _p_periode;
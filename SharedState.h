@@ -0,0 +1,80 @@
+#ifndef _SharedState_H_
+#define _SharedState_H_
+
+#include <stdint.h>
+#include <atomic>
+#include <type_traits>
+
+/*=========================================================================================================================
+	Disposition de la mmoire partage POSIX publie par la simulation (option --shm)
+	Fonction : Permet  d'autres processus locaux de lire les dernires positions sans socket ni copie ct simulation
+
+	Le segment (SHM_NAME par dfaut) contient un Shared_Header suivi de SHM_NB_SLOTS Shared_Slot (tampon circulaire) :
+		++ La simulation crit l'image n dans slots[n % SHM_NB_SLOTS] puis publie header.latest = n + 1 (0 = rien de publi)
+		++ Chaque slot est protg par un seqlock : sequence est impaire pendant l'criture et augmente de 2  chaque image
+		++ Un lecteur lit sequence, copie le slot, relit sequence : la lecture est valide si les deux valeurs sont gales et paires
+	Le producteur n'attend jamais les lecteurs ; un lecteur trop lent recommence simplement sur l'image la plus rcente.
+	Vie du producteur : header.pid est le processus de la simulation et header.closed passe  1 quand elle ferme le segment
+	(le segment est alors supprim : une simulation relance en cre un nouveau, qu'un lecteur ne voit qu'en rouvrant le nom).
+	Aprs un arrt brutal, closed reste  0 mais pid ne correspond plus  un processus vivant ; une simulation relance
+	reprend le mme segment (mmes squences) et y crit son pid.
+	Les invariants (nergie, moment cintique et leurs drives) sont ceux du dernier chantillon de InvariantMonitor (0 si dsactiv).
+	Units : positions en m, vitesses en m/s, temps simul en s, nergie en J, moment cintique en kg.m/s. Tous les champs sont en reprsentation native de la machine.
+==========================================================================================================================*/
+
+#define SHM_NAME "/solar_system_state"
+#define SHM_MAGIC 0x534F4C52	//	"SOLR"
+#define SHM_VERSION 3
+#define SHM_NB_SLOTS 8
+#define SHM_NB_BODIES_MAX 16
+#define SHM_NAME_SIZE 16
+
+//Le seqlock est partag entre processus : les atomiques ne doivent pas dpendre d'un verrou interne au processus.
+//uint64_t est unsigned long (Linux 64 bits) ou unsigned long long selon la plateforme, on vrifie la macro du type rel
+static_assert(std::is_same<uint64_t, unsigned long>::value ? ATOMIC_LONG_LOCK_FREE == 2 : ATOMIC_LLONG_LOCK_FREE == 2,
+	"Le seqlock partag entre processus demande std::atomic<uint64_t> sans verrou");
+static_assert(ATOMIC_INT_LOCK_FREE == 2 && std::is_same<uint32_t, unsigned int>::value,
+	"magic demande std::atomic<uint32_t> sans verrou");
+static_assert(sizeof(std::atomic<uint64_t>) == sizeof(uint64_t) && sizeof(std::atomic<uint32_t>) == sizeof(uint32_t),
+	"Les atomiques doivent avoir la taille du type qu'ils contiennent");
+
+//Etat d'un corps : position (x, y) et vitesse (vx, vy)
+struct Shared_Body {
+	double position[2];
+	double velocity[2];
+};
+
+//Une image de la simulation
+struct alignas(64) Shared_Slot {
+	std::atomic<uint64_t> sequence;		//seqlock : impair = criture en cours
+	uint64_t frame;						//numro de l'image (commence  0)
+	double temps;						//temps simul depuis le dpart
+	uint32_t nb_bodies;
+	uint32_t reserved;
+	double energie;						//nergie totale
+	double moment_cinetique;			//moment cintique total suivant z
+	double derive_energie;				//drive relative depuis le dpart
+	double derive_moment;				//drive relative depuis le dpart
+	Shared_Body bodies[SHM_NB_BODIES_MAX];
+};
+
+//En-tte crit une seule fois  l'ouverture,  l'exception de latest.
+//magic est crit en dernier (release) par la simulation : un lecteur le lit (acquire) avant tout autre champ
+struct alignas(64) Shared_Header {
+	std::atomic<uint32_t> magic;		//SHM_MAGIC, 0 pendant l'criture de l'en-tte
+	uint32_t version;					//SHM_VERSION
+	uint32_t nb_slots;					//SHM_NB_SLOTS
+	uint32_t nb_bodies;					//nombre de corps publis (<= SHM_NB_BODIES_MAX)
+	uint64_t slot_size;					//sizeof(Shared_Slot)
+	std::atomic<uint32_t> closed;		//1 quand la simulation a ferm le segment (release)
+	int32_t pid;						//processus de la simulation qui publie
+	char names[SHM_NB_BODIES_MAX][SHM_NAME_SIZE];	//nom de chaque corps, dans l'ordre de bodies
+	alignas(64) std::atomic<uint64_t> latest;		//dernire image publie + 1
+};
+
+struct Shared_State {
+	Shared_Header header;
+	Shared_Slot slots[SHM_NB_SLOTS];
+};
+
+#endif
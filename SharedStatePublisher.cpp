@@ -0,0 +1,139 @@
+#include <iostream>
+#include <cstring>
+#include <cerrno>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include "SharedStatePublisher.h"
+
+/*======================================================================================================================================================
+	SharedStatePublisher::SharedStatePublisher()
+	Fonction : Initialisation (le segment n'est cr que par Open)
+======================================================================================================================================================*/
+SharedStatePublisher::SharedStatePublisher()
+{
+	_state = NULL;
+	_nom[0] = '\0';
+	_frame = 0;
+}
+
+SharedStatePublisher::~SharedStatePublisher()
+{
+	Close();
+}
+
+/*=====================================================================================================================================================
+	bool SharedStatePublisher::Open(const char* nom, const char* names[], int nb_bodies)
+	Fonction : Cre (ou rouvre) le segment, le dimensionne et crit l'en-tte.
+	magic est remis  0 pendant l'criture de l'en-tte puis crit en dernier pour qu'un lecteur ne voie jamais un en-tte incomplet.
+	Si le segment existe dj avec la mme disposition (simulation relance), les squences et les numros d'image continuent
+	l o ils taient : un lecteur rest connect ne peut pas confondre une nouvelle image avec une ancienne de mme squence
+=====================================================================================================================================================*/
+bool SharedStatePublisher::Open(const char* nom, const char* names[], int nb_bodies)
+{
+	if (nb_bodies > SHM_NB_BODIES_MAX) {
+		std::cout << "Memoire partagee : " << nb_bodies << " corps, maximum " << SHM_NB_BODIES_MAX << std::endl;
+		return false;
+	}
+
+	int fd = shm_open(nom, O_CREAT | O_RDWR, 0644);
+	if (fd < 0) {
+		std::cout << "Memoire partagee : shm_open(" << nom << ") impossible : " << strerror(errno) << std::endl;
+		return false;
+	}
+	if (ftruncate(fd, sizeof(Shared_State)) != 0) {
+		std::cout << "Memoire partagee : ftruncate impossible : " << strerror(errno) << std::endl;
+		close(fd);
+		return false;
+	}
+	void* adresse = mmap(NULL, sizeof(Shared_State), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	close(fd); // Le mapping reste valide aprs la fermeture du descripteur
+	if (adresse == MAP_FAILED) {
+		std::cout << "Memoire partagee : mmap impossible : " << strerror(errno) << std::endl;
+		return false;
+	}
+
+	_state = static_cast<Shared_State*>(adresse);
+	strncpy(_nom, nom, sizeof(_nom) - 1);
+	_nom[sizeof(_nom) - 1] = '\0';
+
+	Shared_Header& header = _state->header;
+	bool existant = header.magic.load(std::memory_order_acquire) == SHM_MAGIC && header.version == SHM_VERSION
+		&& header.nb_slots == SHM_NB_SLOTS && header.slot_size == sizeof(Shared_Slot);
+
+	header.magic.store(0, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release); // magic = 0 est visible avant toute modification de l'en-tte
+	header.version = SHM_VERSION;
+	header.nb_slots = SHM_NB_SLOTS;
+	header.nb_bodies = nb_bodies;
+	header.slot_size = sizeof(Shared_Slot);
+	header.pid = static_cast<int32_t>(getpid());
+	header.closed.store(0, std::memory_order_relaxed);
+	memset(header.names, 0, sizeof(header.names));
+	for (int i = 0; i < nb_bodies; i++) strncpy(header.names[i], names[i], SHM_NAME_SIZE - 1);
+	if (existant) {
+		//Une criture interrompue (arrt brutal) laisse une squence impaire : on la rend paire sans la faire reculer
+		for (int i = 0; i < SHM_NB_SLOTS; i++) {
+			uint64_t sequence = _state->slots[i].sequence.load(std::memory_order_relaxed);
+			if (sequence & 1) _state->slots[i].sequence.store(sequence + 1, std::memory_order_relaxed);
+		}
+		_frame = header.latest.load(std::memory_order_relaxed);
+	}
+	else {
+		header.latest.store(0, std::memory_order_relaxed);
+		for (int i = 0; i < SHM_NB_SLOTS; i++) _state->slots[i].sequence.store(0, std::memory_order_relaxed);
+		_frame = 0;
+	}
+	header.magic.store(SHM_MAGIC, std::memory_order_release);
+
+	return true;
+}
+
+/*=====================================================================================================================================================
+	void SharedStatePublisher::Publish(double temps, Planet* planets[], int nb_bodies, const Invariant_Sample* invariants)
+	Fonction : Ecrit l'image suivante sous seqlock puis avance header.latest
+=====================================================================================================================================================*/
+void SharedStatePublisher::Publish(double temps, Planet* planets[], int nb_bodies, const Invariant_Sample* invariants)
+{
+	if (_state == NULL) return;
+
+	Shared_Slot& slot = _state->slots[_frame % SHM_NB_SLOTS];
+	uint64_t sequence = slot.sequence.load(std::memory_order_relaxed);
+
+	slot.sequence.store(sequence + 1, std::memory_order_relaxed); // impair : criture en cours
+	std::atomic_thread_fence(std::memory_order_release);
+
+	slot.frame = _frame;
+	slot.temps = temps;
+	slot.nb_bodies = nb_bodies;
+	slot.energie = (invariants != NULL) ? invariants->energie : 0;
+	slot.moment_cinetique = (invariants != NULL) ? invariants->moment_cinetique : 0;
+	slot.derive_energie = (invariants != NULL) ? invariants->derive_energie : 0;
+	slot.derive_moment = (invariants != NULL) ? invariants->derive_moment : 0;
+	for (int i = 0; i < nb_bodies; i++) {
+		slot.bodies[i].position[0] = planets[i]->get_position_x();
+		slot.bodies[i].position[1] = planets[i]->get_position_y();
+		slot.bodies[i].velocity[0] = planets[i]->get_velocity_x();
+		slot.bodies[i].velocity[1] = planets[i]->get_velocity_y();
+	}
+
+	slot.sequence.store(sequence + 2, std::memory_order_release);
+	_state->header.latest.store(_frame + 1, std::memory_order_release);
+	++_frame;
+}
+
+/*=====================================================================================================================================================
+	void SharedStatePublisher::Close(void)
+	Fonction : Libre le segment. Les lecteurs dj connects gardent leur mapping jusqu' leur propre fermeture :
+	closed leur indique que plus aucune image ne sera publie dans ce segment
+=====================================================================================================================================================*/
+void SharedStatePublisher::Close(void)
+{
+	if (_state == NULL) return;
+	_state->header.closed.store(1, std::memory_order_release);
+	munmap(_state, sizeof(Shared_State));
+	shm_unlink(_nom);
+	_state = NULL;
+}
@@ -0,0 +1,35 @@
+#ifndef _SharedStatePublisher_H_
+#define _SharedStatePublisher_H_
+
+#include "SharedState.h"
+#include "Planet.h"
+#include "Invariants.h"
+
+/*=========================================================================================================================
+	class SharedStatePublisher
+	Fonction :
+		++ Cre le segment de mmoire partage POSIX et crit l'en-tte (voir SharedState.h)
+		++ Publie  chaque image la position et la vitesse de chaque plante dans le slot suivant du tampon circulaire
+==========================================================================================================================*/
+
+class SharedStatePublisher {
+public:
+	SharedStatePublisher();
+	~SharedStatePublisher();
+
+	//\\//\\Cre le segment nom et enregistre le nom de chaque corps. Retourne false en cas d'chec \\//\\//
+	bool Open(const char* nom, const char* names[], int nb_bodies);
+
+	//\\//\\Publie l'tat courant des plantes et le dernier chantillon d'invariants s'il existe (aucune attente sur les lecteurs) \\//\\//
+	void Publish(double temps, Planet* planets[], int nb_bodies, const Invariant_Sample* invariants = NULL);
+
+	//\\//\\Dmappe et supprime le segment \\//\\//
+	void Close(void);
+
+private:
+	Shared_State* _state;
+	char _nom[64];
+	uint64_t _frame;
+};
+
+#endif
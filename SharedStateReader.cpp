@@ -0,0 +1,118 @@
+#include <cstring>
+#include <cerrno>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include <signal.h>
+
+#include "SharedStateReader.h"
+
+/*======================================================================================================================================================
+	SharedStateReader::SharedStateReader()
+	Fonction : Initialisation (le segment n'est mapp que par Open)
+======================================================================================================================================================*/
+SharedStateReader::SharedStateReader()
+{
+	_state = NULL;
+	_retries = 0;
+}
+
+SharedStateReader::~SharedStateReader()
+{
+	Close();
+}
+
+/*=====================================================================================================================================================
+	bool SharedStateReader::Open(const char* nom)
+	Fonction : Mappe le segment en lecture seule et vrifie que sa disposition correspond  SharedState.h
+=====================================================================================================================================================*/
+bool SharedStateReader::Open(const char* nom)
+{
+	Close();
+
+	int fd = shm_open(nom, O_RDONLY, 0);
+	if (fd < 0) return false;
+	void* adresse = mmap(NULL, sizeof(Shared_State), PROT_READ, MAP_SHARED, fd, 0);
+	close(fd);
+	if (adresse == MAP_FAILED) return false;
+
+	const Shared_State* state = static_cast<const Shared_State*>(adresse);
+	const Shared_Header& header = state->header;
+
+	//magic est lu (acquire) avant tous les autres champs : s'il vaut SHM_MAGIC, l'en-tte crit avant lui est complet.
+	//Il est relu aprs : si la simulation a rouvert le segment entre temps, l'en-tte lu peut tre incohrent
+	bool valide = header.magic.load(std::memory_order_acquire) == SHM_MAGIC;
+	valide = valide && header.version == SHM_VERSION && header.nb_slots == SHM_NB_SLOTS && header.slot_size == sizeof(Shared_Slot)
+		&& header.nb_bodies <= SHM_NB_BODIES_MAX;
+	std::atomic_thread_fence(std::memory_order_acquire);
+	valide = valide && header.magic.load(std::memory_order_relaxed) == SHM_MAGIC;
+	if (!valide) {
+		munmap(adresse, sizeof(Shared_State));
+		return false;
+	}
+
+	_state = state;
+	return true;
+}
+
+/*=====================================================================================================================================================
+	bool SharedStateReader::Alive(void)
+	Fonction : La simulation publie encore si elle n'a pas ferm le segment et si son processus existe.
+	kill(pid, 0) n'envoie aucun signal : ESRCH = processus disparu (EPERM = processus d'un autre utilisateur, donc vivant)
+=====================================================================================================================================================*/
+bool SharedStateReader::Alive(void)
+{
+	if (_state == NULL) return false;
+	if (_state->header.closed.load(std::memory_order_acquire) != 0) return false;
+	if (kill(static_cast<pid_t>(_state->header.pid), 0) != 0 && errno == ESRCH) return false;
+	return true;
+}
+
+uint64_t SharedStateReader::Latest(void)
+{
+	return (_state != NULL) ? _state->header.latest.load(std::memory_order_acquire) : 0;
+}
+
+/*=====================================================================================================================================================
+	bool SharedStateReader::Read(Shared_Frame& frame)
+	Fonction : Lecture sous seqlock du slot le plus rcent. Si le producteur crit dans ce slot pendant la copie,
+	la squence a chang et on recommence sur l'image la plus rcente
+=====================================================================================================================================================*/
+bool SharedStateReader::Read(Shared_Frame& frame)
+{
+	if (_state == NULL) return false;
+
+	while (true) {
+		uint64_t latest = _state->header.latest.load(std::memory_order_acquire);
+		if (latest == 0) return false;
+
+		const Shared_Slot& slot = _state->slots[(latest - 1) % SHM_NB_SLOTS];
+		uint64_t sequence = slot.sequence.load(std::memory_order_acquire);
+		if (sequence & 1) {
+			++_retries;
+			continue;
+		}
+
+		frame.frame = slot.frame;
+		frame.temps = slot.temps;
+		frame.nb_bodies = slot.nb_bodies;
+		frame.energie = slot.energie;
+		frame.moment_cinetique = slot.moment_cinetique;
+		frame.derive_energie = slot.derive_energie;
+		frame.derive_moment = slot.derive_moment;
+		if (frame.nb_bodies > SHM_NB_BODIES_MAX) frame.nb_bodies = SHM_NB_BODIES_MAX; // valeur incohrente : rejete par la squence
+		memcpy(frame.bodies, slot.bodies, frame.nb_bodies * sizeof(Shared_Body));
+
+		std::atomic_thread_fence(std::memory_order_acquire);
+		if (slot.sequence.load(std::memory_order_relaxed) == sequence) return true;
+		++_retries;
+	}
+}
+
+void SharedStateReader::Close(void)
+{
+	if (_state == NULL) return;
+	munmap(const_cast<Shared_State*>(_state), sizeof(Shared_State));
+	_state = NULL;
+}
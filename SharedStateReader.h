@@ -0,0 +1,69 @@
+#ifndef _SharedStateReader_H_
+#define _SharedStateReader_H_
+
+#include "SharedState.h"
+
+/*=========================================================================================================================
+	struct Shared_Frame
+	Fonction : Copie cohrente d'une image lue dans la mmoire partage
+==========================================================================================================================*/
+
+struct Shared_Frame {
+	uint64_t frame;
+	double temps;
+	uint32_t nb_bodies;
+	double energie;
+	double moment_cinetique;
+	double derive_energie;
+	double derive_moment;
+	Shared_Body bodies[SHM_NB_BODIES_MAX];
+};
+
+/*=========================================================================================================================
+	class SharedStateReader
+	Fonction :
+		++ Mappe en lecture seule le segment publi par la simulation (voir SharedState.h)
+		++ Lit la dernire image publie sans jamais bloquer la simulation
+	Plusieurs lecteurs (processus) peuvent tre ouverts en mme temps sur le mme segment
+==========================================================================================================================*/
+
+class SharedStateReader {
+public:
+	SharedStateReader();
+	~SharedStateReader();
+
+	//\\//\\Ouvre le segment nom. Retourne false s'il n'existe pas ou si sa disposition est incompatible \\//\\//
+	bool Open(const char* nom = SHM_NAME);
+
+	//\\//\\Copie la dernire image publie dans frame. Retourne false si rien n'a encore t publi \\//\\//
+	bool Read(Shared_Frame& frame);
+
+	//\\//\\Retourne false si la simulation a ferm le segment ou s'est arrte : latest n'avancera plus. \\//\\//
+	//\\//\\Une simulation relance proprement publie dans un nouveau segment, il faut alors rappeler Open \\//\\//
+	bool Alive(void);
+
+	//\\//\\Retourne le numro de la dernire image publie + 1 (0 = aucune), sans copie \\//\\//
+	uint64_t Latest(void);
+
+	//\\//\\Retourne le nombre de corps et leur nom ("" si i est hors de [0, nb_bodies[ ou si le segment n'est pas ouvert) \\//\\//
+	int get_nb_bodies() {
+		return (_state != NULL) ? static_cast<int>(_state->header.nb_bodies) : 0;
+	}
+	const char* get_name(int i) {
+		if (i < 0 || i >= get_nb_bodies()) return "";
+		return _state->header.names[i];
+	}
+
+	//\\//\\Retourne le nombre de lectures recommences parce que le slot tait en cours d'criture \\//\\//
+	uint64_t get_retries() {
+		return _retries;
+	}
+
+	void Close(void);
+
+private:
+	const Shared_State* _state;
+	uint64_t _retries;
+};
+
+#endif
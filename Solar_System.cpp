@@ -48,7 +48,20 @@
 #include <vtkPointSource.h>
 #include <vtkPolyData.h>
 
+#include <cstdio>
+#include <cstring>
+#include <algorithm>
+#include <memory>
+#include <thread>
+
 #include "Planet.h"
+#include "FrameExporter.h"
+#include "Parareal.h"
+#include "SharedState.h"
+#include "Invariants.h"
+#ifdef SOLAR_SHM
+#include "SharedStatePublisher.h"
+#endif
 
 /*==========================================================================================
 	vtkSmartPointer<vtkActor> DrawLine(double position_new[3], double position_last[3])
@@ -113,6 +126,12 @@ public:
 	{
 		vtkTimerCallback* cb = new vtkTimerCallback;
 		cb->TimerCount = 0;
+		cb->exporter = NULL;
+		cb->monitor = NULL;
+		cb->verbose = true;
+#ifdef SOLAR_SHM
+		cb->publisher = NULL;
+#endif
 		return cb;
 	}
 
@@ -128,56 +147,77 @@ public:
 		static Planet Saturn(PERIODEsaturne, MASSEsaturne, MASSEsoleil, 0, (2. * pi * DISTANCEsoleilsaturne / PERIODEsaturne), DISTANCEsoleilsaturne, 0);
 
 		
-		int LockIN = 3600;
+		static double pas_suivant = h; // pas demand par le moniteur d'invariants avec --auto-pas
+		double pas = pas_suivant; // le pas ne change qu'entre deux interruptions pour que LockIN corresponde au pas rellement utilis
+		int LockIN = static_cast<int>(3600 * h / pas + 0.5); // mme temps simul par interruption quel que soit le pas
 		static double position_Mercury[3] = { 0, 0, 0 };
 		static double position_Venus[3] = { 0, 0, 0 };
 		static double position_Earth[3] = { 0, 0, 0 };
 		static double position_Mars[3] = { 0, 0, 0 };
 		static double position_Jupiter[3] = { 0, 0, 0 };
 		static double position_Saturn[3] = { 0, 0, 0 };
+		static double temps = 0; // temps simul depuis le dpart (s)
 		while (LockIN != 0) {
 			--LockIN;
-			std::cout << "Status : " << LockIN << std::endl;
+			bool echantillon = (monitor != NULL) && monitor->Begin_sample(temps);
+			temps += pas;
+			if (verbose) std::cout << "Status : " << LockIN << std::endl;
 
 			//\\//\\Lors de chaque interruptions je calcule la position de chaque plante\\//\\//
 			Mercury.distance();
-			Mercury.Update_position_Runge_Kutta(2);
-			Mercury.Update_position_Runge_Kutta(1);
+			if (echantillon) monitor->Accumulate(Mercury);
+			Mercury.Update_position_Runge_Kutta(2, pas);
+			Mercury.Update_position_Runge_Kutta(1, pas);
 			position_Mercury[0] = rescale_coordinates(1, Mercury.get_position_x());
 			position_Mercury[1] = rescale_coordinates(1, Mercury.get_position_y());
 
 
 			Venus.distance();
-			Venus.Update_position_Runge_Kutta(2);
-			Venus.Update_position_Runge_Kutta(1);
+			if (echantillon) monitor->Accumulate(Venus);
+			Venus.Update_position_Runge_Kutta(2, pas);
+			Venus.Update_position_Runge_Kutta(1, pas);
 			position_Venus[0] = rescale_coordinates(1, Venus.get_position_x());
 			position_Venus[1] = rescale_coordinates(1, Venus.get_position_y());
 
 			Earth.distance();
-			Earth.Update_position_Runge_Kutta(2);
-			Earth.Update_position_Runge_Kutta(1);
+			if (echantillon) monitor->Accumulate(Earth);
+			Earth.Update_position_Runge_Kutta(2, pas);
+			Earth.Update_position_Runge_Kutta(1, pas);
 			position_Earth[0] = rescale_coordinates(1, Earth.get_position_x());
 			position_Earth[1] = rescale_coordinates(1, Earth.get_position_y());
 
 			Mars.distance();
-			Mars.Update_position_Runge_Kutta(2);
-			Mars.Update_position_Runge_Kutta(1);
+			if (echantillon) monitor->Accumulate(Mars);
+			Mars.Update_position_Runge_Kutta(2, pas);
+			Mars.Update_position_Runge_Kutta(1, pas);
 			position_Mars[0] = rescale_coordinates(1, Mars.get_position_x());
 			position_Mars[1] = rescale_coordinates(1, Mars.get_position_y());
 
 			Jupiter.distance();
-			Jupiter.Update_position_Runge_Kutta(2);
-			Jupiter.Update_position_Runge_Kutta(1);
+			if (echantillon) monitor->Accumulate(Jupiter);
+			Jupiter.Update_position_Runge_Kutta(2, pas);
+			Jupiter.Update_position_Runge_Kutta(1, pas);
 			position_Jupiter[0] = rescale_coordinates(1, Jupiter.get_position_x());
 			position_Jupiter[1] = rescale_coordinates(1, Jupiter.get_position_y());
 
 			Saturn.distance();
-			Saturn.Update_position_Runge_Kutta(2);
-			Saturn.Update_position_Runge_Kutta(1);
+			if (echantillon) monitor->Accumulate(Saturn);
+			Saturn.Update_position_Runge_Kutta(2, pas);
+			Saturn.Update_position_Runge_Kutta(1, pas);
 			position_Saturn[0] = rescale_coordinates(1, Saturn.get_position_x());
 			position_Saturn[1] = rescale_coordinates(1, Saturn.get_position_y());
 
+			//\\//\\Les contributions de toutes les plantes sont cumules : bilan et ventuel changement du pas  la prochaine interruption\\//\\//
+			if (echantillon) pas_suivant = monitor->End_sample(pas);
+		}
+
+#ifdef SOLAR_SHM
+		//\\//\\Publication de l'tat des plantes pour les lecteurs externes (mmoire partage)\\//\\//
+		if (publisher != NULL) {
+			Planet* planets[NB_Planet - 1] = { &Mercury, &Venus, &Earth, &Mars, &Jupiter, &Saturn };
+			publisher->Publish(temps, planets, NB_Planet - 1, (monitor != NULL) ? monitor->get_last() : NULL);
 		}
+#endif
 
 		
 
@@ -309,6 +349,9 @@ public:
 			actor_Saturn_Rings->SetPosition(position_Saturn);
 			renderWindow->Render();
 
+			//\\//\\En mode hors cran chaque image rendue part dans la file d'export PNG\\//\\//
+			if (exporter != NULL) exporter->Capture(renderWindow);
+
 		}
 	}
 
@@ -327,6 +370,12 @@ public:
 	vtkSmartPointer<vtkActor> actor_Moon;
 	vtkSmartPointer<vtkRenderer> renderer;
 	vtkSmartPointer<vtkRenderWindow> renderWindow;
+	FrameExporter* exporter;
+	InvariantMonitor* monitor;
+	bool verbose;	//affiche l'avancement de chaque pas (dsactiv en hors cran : la console limiterait la vitesse d'export)
+#ifdef SOLAR_SHM
+	SharedStatePublisher* publisher;
+#endif
 
 	//\\//\\ Mapper for Planet line orbit
 	vtkSmartPointer<vtkPolyDataMapper> mapperLine = vtkSmartPointer<vtkPolyDataMapper>::New();
@@ -348,6 +397,117 @@ private:
 
 };
 
+/*=========================================================================================================================
+	void Print_usage(const char* programme)
+	Fonction : Affiche la ligne de commande attendue
+==========================================================================================================================*/
+
+void Print_usage(const char* programme)
+{
+	std::cout << "Usage: " << programme
+		<< " texture(.png)"
+		<< " [translate]"
+		<< " [--offscreen dossier nb_images [largeurxhauteur]]"
+		<< " [--invariants cadence budget fichier] [--auto-pas]"
+		<< " [--shm [nom]]" << std::endl;
+	std::cout << "       " << programme << " --parareal nb_annees nb_tranches [pas_grossier] [tolerance] [--reference]" << std::endl;
+}
+
+/*=========================================================================================================================
+	int Run_Parareal(int argc, char* argv[])
+	Fonction : Intgration longue dure sans affichage avec Parareal
+	Paramtres (aprs --parareal) :
+		nb_annees : dure simule en annes terrestres
+		nb_tranches : nombre de tranches de temps propages en parallle
+		pas_grossier (optionnel) : pas du propagateur grossier en secondes (PAS_grossier par dfaut)
+		tolerance (optionnel) : fraction de l'erreur du propagateur fin (PARAREAL_tolerance par dfaut)
+		--reference (optionnel) : refait toute l'intgration fine en srie pour mesurer le speedup rel et l'erreur ;
+			sans elle, le temps srie est estim par la somme des tranches fines de la premire itration
+
+	Les tranches sont limites  une fraction de la priode de chaque plante (voir Parareal.h), la dure est donc parcourue en fentres.
+	Pour chaque plante j'affiche le nombre de fentres, d'itrations, la raison de l'arrt et le speedup mesur sur cette machine
+	ainsi que le speedup idal avec un coeur par tranche
+==========================================================================================================================*/
+
+int Run_Parareal(int argc, char* argv[])
+{
+	double duree = atof(argv[2]) * PERIODEterre;
+	int nb_tranches = atoi(argv[3]);
+	double pas_grossier = PAS_grossier;
+	double tolerance = PARAREAL_tolerance;
+	bool reference = false;
+	int position = 0;
+	for (int i = 4; i < argc; i++) {
+		if (strcmp(argv[i], "--reference") == 0) reference = true;
+		else if (position == 0) {
+			pas_grossier = atof(argv[i]);
+			++position;
+		}
+		else if (position == 1) {
+			tolerance = atof(argv[i]);
+			++position;
+		}
+		else {
+			std::cout << "--parareal : argument en trop " << argv[i] << std::endl;
+			Print_usage(argv[0]);
+			return EXIT_FAILURE;
+		}
+	}
+
+	//\\//\\atof retourne 0 pour un argument non numrique : il est rejet avec les valeurs nulles ou ngatives\\//\\//
+	if (!(duree > 0) || nb_tranches <= 0) {
+		std::cout << "--parareal : nb_annees (> 0) et nb_tranches (> 0) attendus" << std::endl;
+		Print_usage(argv[0]);
+		return EXIT_FAILURE;
+	}
+	if (!(pas_grossier > h)) {
+		std::cout << "--parareal : le pas grossier doit tre plus grand que le pas fin (" << h << " s)" << std::endl;
+		Print_usage(argv[0]);
+		return EXIT_FAILURE;
+	}
+	if (!(tolerance > 0)) {
+		std::cout << "--parareal : la tolrance doit tre positive" << std::endl;
+		Print_usage(argv[0]);
+		return EXIT_FAILURE;
+	}
+
+	//\\//\\Mmes conditions initiales que dans le programme d'interruption\\//\\//
+	Planet planets[NB_Planet - 1] = {
+		Planet(PERIODEmercure, MASSEmercure, MASSEsoleil, 0, (2. * pi * DISTANCEsoleilmercure / PERIODEmercure), DISTANCEsoleilmercure, 0),
+		Planet(PERIODEvenus, MASSEvenus, MASSEsoleil, 0, (2. * pi * DISTANCEsoleilvenus / PERIODEvenus), DISTANCEsoleilvenus, 0),
+		Planet(PERIODEterre, MASSEterre, MASSEsoleil, 0, (2. * pi * DISTANCEsoleilterre / PERIODEterre), DISTANCEsoleilterre, 0),
+		Planet(PERIODEmars, MASSEmars, MASSEsoleil, 0, (2. * pi * DISTANCEsoleilmars / PERIODEmars), DISTANCEsoleilmars, 0),
+		Planet(PERIODEjupiter, MASSEjupiter, MASSEsoleil, 0, (2. * pi * DISTANCEsoleiljupiter / PERIODEjupiter), DISTANCEsoleiljupiter, 0),
+		Planet(PERIODEsaturne, MASSEsaturne, MASSEsoleil, 0, (2. * pi * DISTANCEsoleilsaturne / PERIODEsaturne), DISTANCEsoleilsaturne, 0)
+	};
+	const char* names[NB_Planet - 1] = { "Mercury", "Venus", "Earth", "Mars", "Jupiter", "Saturn" };
+	int nb_coeurs = std::max(1u, std::thread::hardware_concurrency());
+
+	double total_serie = 0;
+	double total_parareal = 0;
+	double total_ideal = 0;
+	for (int i = 0; i < NB_Planet - 1; i++) {
+		Parareal parareal(duree, nb_tranches, pas_grossier, 0, tolerance, nb_coeurs);
+		Parareal_Result result = parareal.Run(planets[i], reference);
+		total_serie += result.temps_serie;
+		total_parareal += result.temps_parareal;
+		total_ideal += result.temps_serie / result.speedup_ideal;
+
+		std::cout << names[i] << " : " << result.fenetres << " fenetres, " << result.iterations << " iterations au plus";
+		if (result.statut == PARAREAL_PLAFOND) std::cout << " (converg seulement parce que les itrations ont atteint le nombre de tranches)";
+		else if (result.statut == PARAREAL_NON_CONVERGE) std::cout << " (non converg)";
+		std::cout << "\tserie" << (result.reference ? "" : " (estim)") << " : " << result.temps_serie << " s\tparareal : " << result.temps_parareal << " s"
+			<< "\tspeedup : " << result.speedup << "\tspeedup idal (un coeur par tranche) : " << result.speedup_ideal
+			<< "\terreur fine : " << result.erreur_fine;
+		if (result.reference) std::cout << "\terreur : " << result.erreur;
+		std::cout << std::endl;
+	}
+	std::cout << "Total : serie " << total_serie << " s, parareal " << total_parareal << " s, speedup "
+		<< ((total_parareal > 0) ? total_serie / total_parareal : 0) << ", speedup idal " << ((total_ideal > 0) ? total_serie / total_ideal : 0) << std::endl;
+
+	return 0;
+}
+
 /*=========================================================================================================================
 	int main(int argc, char* argv[])
 	Fonction : Programme principal :
@@ -358,15 +518,84 @@ private:
 		5 -> Je cre le renderer et le renderer window
 		6 -> J'ajoute les acteurs dans le renderer
 		7 -> J'initialise l'interracteur et le programme d'interruption
+	Option (aprs les textures) :
+		--offscreen dossier nb_images [largeurxhauteur] : rendu hors cran sans interacteur, chaque image est exporte en PNG
+			dans dossier (cr si besoin),  la taille demande (300x300 par dfaut)
+		--invariants cadence budget fichier : chantillonne nergie et moment cintique tous les cadence pas dans fichier (CSV),
+			alerte quand la drive relative entre deux chantillons dpasse budget
+		--auto-pas : avec --invariants, divise le pas par 2  chaque dpassement du budget et le double  nouveau (jusqu' h)
+			quand la drive reste sous budget / PAS_marge (voir Invariants.h)
+		--shm [nom] : publie l'tat des plantes dans la mmoire partage POSIX nom (voir SharedState.h, systmes POSIX uniquement)
+	Mode sans affichage ( la place des textures) :
+		--parareal nb_annees nb_tranches [pas_grossier] [tolerance] [--reference] : voir Run_Parareal
 ==========================================================================================================================*/
 
 int main(int argc, char* argv[])
 {
+	if (argc > 3 && strcmp(argv[1], "--parareal") == 0)
+	{
+		return Run_Parareal(argc, argv);
+	}
+
 	if (argc < 2)
 	{
-		std::cout << "Usage: " << argv[0]
-			<< " texture(.png)"
-			<< " [translate]" << std::endl;
+		Print_usage(argv[0]);
+		return EXIT_FAILURE;
+	}
+
+	//\\//\\Options places aprs les textures des plantes\\//\\//
+	bool offscreen = false;
+	const char* export_dossier = ".";
+	int nb_images = 0;
+	int export_taille[2] = { 0, 0 };
+	const char* shm_nom = NULL;
+	const char* invariants_fichier = NULL;
+	int invariants_cadence = 0;
+	double invariants_budget = 0;
+	bool auto_pas = false;
+	for (int i = NB_Planet + 1; i < argc; i++) {
+		if (strcmp(argv[i], "--offscreen") == 0) {
+			if (i + 2 >= argc || atoi(argv[i + 2]) <= 0) {
+				std::cout << "--offscreen : dossier et nombre d'images (> 0) attendus" << std::endl;
+				Print_usage(argv[0]);
+				return EXIT_FAILURE;
+			}
+			offscreen = true;
+			export_dossier = argv[i + 1];
+			nb_images = atoi(argv[i + 2]);
+			i += 2;
+			//Taille optionnelle de l'image, sous la forme largeurxhauteur (ex : 1920x1080)
+			if (i + 1 < argc && sscanf(argv[i + 1], "%dx%d", &export_taille[0], &export_taille[1]) == 2) {
+				if (export_taille[0] <= 0 || export_taille[1] <= 0) {
+					std::cout << "--offscreen : taille invalide " << argv[i + 1] << std::endl;
+					return EXIT_FAILURE;
+				}
+				++i;
+			}
+		}
+		else if (strcmp(argv[i], "--invariants") == 0) {
+			//atof retourne 0 pour un budget mal crit : il dclencherait une alerte  chaque chantillon
+			if (i + 3 >= argc || atoi(argv[i + 1]) <= 0 || !(atof(argv[i + 2]) > 0)) {
+				std::cout << "--invariants : cadence (> 0), budget (> 0) et fichier attendus" << std::endl;
+				Print_usage(argv[0]);
+				return EXIT_FAILURE;
+			}
+			invariants_cadence = atoi(argv[i + 1]);
+			invariants_budget = atof(argv[i + 2]);
+			invariants_fichier = argv[i + 3];
+			i += 3;
+		}
+		else if (strcmp(argv[i], "--auto-pas") == 0) {
+			auto_pas = true;
+		}
+		else if (strcmp(argv[i], "--shm") == 0) {
+			shm_nom = SHM_NAME;
+			if (i + 1 < argc && argv[i + 1][0] == '/') shm_nom = argv[++i];
+		}
+	}
+	if (auto_pas && invariants_fichier == NULL) {
+		std::cout << "--auto-pas demande --invariants" << std::endl;
+		Print_usage(argv[0]);
 		return EXIT_FAILURE;
 	}
 	double translate[3];
@@ -389,6 +618,22 @@ int main(int argc, char* argv[])
 	// Sign up to receive TimerEvent
 	vtkSmartPointer<vtkTimerCallback> cb = vtkSmartPointer<vtkTimerCallback>::New();
 
+	std::unique_ptr<InvariantMonitor> monitor;
+	if (invariants_fichier != NULL) {
+		monitor.reset(new InvariantMonitor(invariants_cadence, invariants_budget, invariants_fichier, auto_pas));
+		cb->monitor = monitor.get();
+	}
+
+#ifdef SOLAR_SHM
+	SharedStatePublisher publisher;
+	if (shm_nom != NULL) {
+		const char* names[NB_Planet - 1] = { "Mercury", "Venus", "Earth", "Mars", "Jupiter", "Saturn" };
+		if (publisher.Open(shm_nom, names, NB_Planet - 1)) cb->publisher = &publisher;
+	}
+#else
+	if (shm_nom != NULL) std::cout << "--shm n'est disponible que sur les systmes POSIX" << std::endl;
+#endif
+
 	/////////////////////////////////UPDATE/////////////////////////////////////////////
 	vtkSmartPointer<vtkTexturedSphereSource> Sphere_Planet[NB_Planet];
 	vtkSmartPointer<vtkImageReader2Factory> readerFactory[NB_Planet];
@@ -526,6 +771,26 @@ int main(int argc, char* argv[])
 	renderer->AddActor(actor_Saturn_Rings);
 	renderer->AddActor(actor_Orion_Belt);
 
+	//\\//\\Mode hors cran : pas d'interacteur ni de timer, on enchane les images aussi vite que possible\\//\\//
+	if (offscreen) {
+		renderWindow->SetOffScreenRendering(1);
+		if (export_taille[0] > 0) renderWindow->SetSize(export_taille[0], export_taille[1]);
+		cb->renderWindow = renderWindow;
+
+		FrameExporter exporter;
+		if (!exporter.Open(export_dossier)) {
+			return EXIT_FAILURE;
+		}
+		cb->exporter = &exporter;
+		cb->verbose = false;
+		for (int i = 0; i < nb_images; i++) {
+			cb->Execute(NULL, vtkCommand::TimerEvent, NULL);
+		}
+		exporter.Finish();
+		cb->exporter = NULL;
+		return 0;
+	}
+
 	vtkSmartPointer<vtkRenderWindowInteractor> interactor = vtkSmartPointer<vtkRenderWindowInteractor>::New();
 	interactor->SetRenderWindow(renderWindow);
 
@@ -0,0 +1,59 @@
+/************************************************************************
+ * Lecteur de test de la mmoire partage publie par Solar_System --shm
+ * Usage : Solar_System_Reader [nom] [nb_lectures] [intervalle_ms]
+ ************************************************************************/
+
+#include <iostream>
+#include <cstdlib>
+#include <thread>
+#include <chrono>
+
+#include "SharedStateReader.h"
+
+/*=========================================================================================================================
+	int main(int argc, char* argv[])
+	Fonction : Lit nb_lectures fois la dernire image publie et affiche la position de chaque corps.
+	Quand la simulation s'arrte, le signale et rouvre le segment  chaque lecture jusqu' ce qu'une simulation soit relance.
+	A la fin, affiche le nombre d'images vues et le nombre de lectures recommences (conflit avec l'criture)
+==========================================================================================================================*/
+
+int main(int argc, char* argv[])
+{
+	const char* nom = (argc > 1) ? argv[1] : SHM_NAME;
+	int nb_lectures = (argc > 2) ? atoi(argv[2]) : 100;
+	int intervalle = (argc > 3) ? atoi(argv[3]) : 100;
+
+	SharedStateReader reader;
+	if (!reader.Open(nom)) {
+		std::cout << "Impossible d'ouvrir " << nom << " (lancer Solar_System avec --shm)" << std::endl;
+		return EXIT_FAILURE;
+	}
+
+	Shared_Frame frame;
+	uint64_t derniere = 0;
+	uint64_t nb_images = 0;
+	bool en_ligne = true;
+	for (int i = 0; i < nb_lectures; i++) {
+		//Une simulation relance proprement publie dans un nouveau segment du mme nom : on le rouvre
+		bool vivant = reader.Alive() || (reader.Open(nom) && reader.Alive());
+		if (vivant != en_ligne) {
+			std::cout << (vivant ? "Simulation relancee" : "Simulation arretee, attente d'une nouvelle publication") << std::endl;
+			en_ligne = vivant;
+		}
+
+		if (reader.Read(frame) && (nb_images == 0 || frame.frame != derniere)) {
+			derniere = frame.frame;
+			++nb_images;
+			std::cout << "image " << frame.frame << "\tt = " << frame.temps / 86400. << " j"
+				<< "\tdE = " << frame.derive_energie << "\tdL = " << frame.derive_moment;
+			for (uint32_t j = 0; j < frame.nb_bodies; j++) {
+				std::cout << "\t" << reader.get_name(j) << " (" << frame.bodies[j].position[0] << ", " << frame.bodies[j].position[1] << ")";
+			}
+			std::cout << std::endl;
+		}
+		std::this_thread::sleep_for(std::chrono::milliseconds(intervalle));
+	}
+
+	std::cout << nb_images << " images lues, " << reader.get_retries() << " lectures recommencees" << std::endl;
+	return 0;
+}